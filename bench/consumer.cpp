@@ -0,0 +1,46 @@
+/***************************************************************************
+* Copyright (c) 2020, QuantStack and xeus-SQLite contributors              *
+*                                                                          *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+/**
+    Stand-in for a kernel translation unit using the bindings, compiled
+    several times by measure.sh with a different CONSUMER_ID.
+**/
+#include <string>
+#include <vector>
+
+#include "xvega-bindings/xvega_bindings.hpp"
+
+#ifndef CONSUMER_ID
+#define CONSUMER_ID 0
+#endif
+
+#define XV_BINDINGS_CAT_IMPL(a, b) a##b
+#define XV_BINDINGS_CAT(a, b) XV_BINDINGS_CAT_IMPL(a, b)
+
+nl::json XV_BINDINGS_CAT(consumer_, CONSUMER_ID)(const std::string& code, xv::df_type df)
+{
+    std::vector<std::string> tokenized_input = xv_bindings::tokenizer(code);
+    if (!xv_bindings::is_xvega(tokenized_input))
+    {
+        return nl::json();
+    }
+    tokenized_input.erase(tokenized_input.begin());
+    return xv_bindings::process_xvega_input(tokenized_input, df);
+}
+
+#if CONSUMER_ID == 0
+int main()
+{
+    xv::df_type df;
+    df["a"].push_back(1.5);
+    df["b"].push_back(2.5);
+    consumer_0("XVEGA_PLOT X_FIELD a Y_FIELD b MARK BAR", df);
+    return 0;
+}
+#endif
@@ -0,0 +1,63 @@
+#!/usr/bin/env bash
+# Compile time and binary size of a consumer of the bindings, header-only
+# versus linked against the precompiled library.
+#
+# Usage: bench/measure.sh <library build dir> [number of translation units]
+#
+# CXXFLAGS must point at the xvega, xtl and nlohmann_json headers and
+# LDFLAGS at whatever xvega needs to link, eg. for a conda environment:
+#
+#   CXXFLAGS="-I$CONDA_PREFIX/include" LDFLAGS="-L$CONDA_PREFIX/lib -lxvega" \
+#       bench/measure.sh _build 4
+#
+# Without xvega, bench/stub provides stand-in headers; the library must then
+# be configured against the same stub. Figures obtained this way only cover
+# the parsers and nlohmann_json, not xvega's serialization:
+#
+#   CXXFLAGS="-Ibench/stub -I<nlohmann_json include dir>" bench/measure.sh _build 4
+
+set -euo pipefail
+
+BUILD_DIR=$(cd "$1" && pwd)
+NUM_TU=${2:-4}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+CXX=${CXX:-c++}
+FLAGS="-std=c++17 -O2 -I$ROOT/include ${CXXFLAGS:-}"
+
+measure()
+{
+    local mode=$1 defines=$2 libs=$3
+    local start end
+    start=$(date +%s%N)
+    for i in $(seq 0 $((NUM_TU - 1))); do
+        $CXX $FLAGS $defines -DCONSUMER_ID=$i -c "$ROOT/bench/consumer.cpp" -o "$WORK/$mode$i.o"
+    done
+    end=$(date +%s%N)
+    $CXX "$WORK"/$mode*.o -o "$WORK/$mode" $libs ${LDFLAGS:-}
+    strip "$WORK/$mode"
+    printf "%-12s compile %6.1f s  objects %10d B  stripped executable %10d B\n" \
+        "$mode" "$(awk -v s="$start" -v e="$end" 'BEGIN { print (e - s) / 1e9 }')" \
+        "$(cat "$WORK"/$mode*.o | wc -c)" "$(stat -c%s "$WORK/$mode")"
+}
+
+measure header-only "" ""
+measure precompiled "-DXVEGA_BINDINGS_PRECOMPILED" "-L$BUILD_DIR -lxvega-bindings -Wl,-rpath,$BUILD_DIR"
+
+for lib in "$BUILD_DIR"/libxvega-bindings.so "$BUILD_DIR"/libxvega-bindings.a; do
+    if [ -f "$lib" ]; then
+        cp "$lib" "$WORK/lib"
+        case "$lib" in
+            *.so) strip "$WORK/lib" ;;
+            *) strip --strip-debug "$WORK/lib" ;;
+        esac
+        case "$lib" in
+            *.so) symbols=$(nm -D --defined-only "$lib" | wc -l) ;;
+            *) symbols=$(nm --defined-only --extern-only "$lib" | grep -c ' [A-Z] ' || true) ;;
+        esac
+        printf "%-12s stripped %d B, %d exported symbols\n" "$(basename "$lib")" \
+            "$(stat -c%s "$WORK/lib")" "$symbols"
+    fi
+done
@@ -0,0 +1,145 @@
+/***************************************************************************
+* Copyright (c) 2020, QuantStack and xeus-SQLite contributors              *
+*                                                                          *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+/**
+    Minimal stand-in for the xvega headers, only used by bench/measure.sh
+    when xvega is not installed. It covers the parts of the API the bindings
+    use: `mime_bundle_repr` returns an empty bundle and cells are a variant
+    of double, int and string. Figures measured with it leave out xvega's
+    own serialization code.
+**/
+
+#ifndef XVEGA_BINDINGS_BENCH_STUB_XVEGA_HPP
+#define XVEGA_BINDINGS_BENCH_STUB_XVEGA_HPP
+
+#include <any>
+#include <map>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+namespace xtl
+{
+    using std::any;
+    using std::any_cast;
+    using std::get;
+    using std::variant;
+    using std::visit;
+}
+
+namespace xv
+{
+    template <class T>
+    struct property
+    {
+        std::optional<T> m_value;
+
+        std::optional<T>& operator()() { return m_value; }
+        const std::optional<T>& operator()() const { return m_value; }
+
+        property& operator=(const T& value)
+        {
+            m_value = value;
+            return *this;
+        }
+    };
+
+    using cell_type = std::variant<double, int, std::string>;
+    using df_type = std::map<std::string, std::vector<cell_type>>;
+
+    struct Bin
+    {
+        property<double> anchor, base, maxbins, minstep, step;
+        property<bool> binned, nice;
+    };
+
+    struct field_encoding
+    {
+        property<std::string> field, type, aggregate, timeUnit;
+        property<std::variant<bool, Bin>> bin;
+    };
+
+    struct X : field_encoding {};
+    struct Y : field_encoding {};
+
+    struct Encodings
+    {
+        property<X> x;
+        property<Y> y;
+    };
+
+    struct axis_config
+    {
+        std::optional<bool> m_grid;
+        std::optional<bool>& grid() { return m_grid; }
+        axis_config& grid(bool value) { m_grid = value; return *this; }
+    };
+
+    struct Config
+    {
+        std::optional<axis_config> m_axis;
+        std::optional<axis_config>& axis() { return m_axis; }
+        Config& axis(axis_config value) { m_axis = value; return *this; }
+    };
+
+    struct mark_base
+    {
+        property<std::string> color;
+    };
+
+    struct mark_arc : mark_base {};
+    struct mark_area : mark_base {};
+    struct mark_bar : mark_base {};
+    struct mark_circle : mark_base {};
+    struct mark_line : mark_base {};
+    struct mark_point : mark_base {};
+    struct mark_rect : mark_base {};
+    struct mark_rule : mark_base {};
+    struct mark_square : mark_base {};
+    struct mark_tick : mark_base {};
+    struct mark_trail : mark_base {};
+
+    struct data_frame
+    {
+        df_type values;
+    };
+
+    struct Chart
+    {
+        property<Encodings> encoding;
+        property<data_frame> data;
+        property<Config> config;
+        property<int> width, height;
+        std::any m_mark;
+
+        std::any& mark() { return m_mark; }
+    };
+
+    inline nlohmann::json mime_bundle_repr(const Chart&)
+    {
+        return nlohmann::json::object();
+    }
+}
+
+namespace nlohmann
+{
+    template <>
+    struct adl_serializer<xv::cell_type>
+    {
+        static void to_json(json& j, const xv::cell_type& cell)
+        {
+            std::visit([&](const auto& value) { j = value; }, cell);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,239 @@
+/***************************************************************************
+* Copyright (c) 2020, QuantStack and xeus-SQLite contributors              *
+*                                                                          *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XVEGA_BINDINGS_PAYLOAD_HPP
+#define XVEGA_BINDINGS_PAYLOAD_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "xvega/xvega.hpp"
+
+#include "utils.hpp"
+
+namespace nl = nlohmann;
+
+namespace xv_bindings
+{
+    /** Number of cells per column that are serialized to estimate its size **/
+    constexpr std::size_t payload_sample_size = 64;
+
+    /** What to do when the estimated payload is bigger than `max_bytes` **/
+    enum class overflow_action
+    {
+        sample,
+        project,
+        error
+    };
+
+    /**
+        Size policy applied to the data frame before the chart is serialized.
+        A `max_bytes` of zero disables the policy.
+    **/
+    struct payload_policy
+    {
+        std::size_t max_bytes = 0;
+        overflow_action on_overflow = overflow_action::error;
+    };
+
+    struct column_estimate
+    {
+        std::string name;
+        std::size_t rows = 0;
+        /** Mean serialized size of a sampled cell, key excluded **/
+        double mean_value_bytes = 0;
+        /** Ratio of distinct values among the sampled cells **/
+        double distinct_ratio = 0;
+        /** Estimated bytes emitted for this column across all rows **/
+        std::size_t bytes = 0;
+    };
+
+    struct payload_estimate
+    {
+        std::vector<column_estimate> columns;
+        std::size_t rows = 0;
+        std::size_t total_bytes = 0;
+    };
+
+    inline column_estimate estimate_column(const std::string& name,
+                                           const xv::df_type::mapped_type& values)
+    {
+        /*
+            Serializes an evenly spaced sample of cells and extrapolates to the
+            whole column. Each row emits the cell as `"name":value,` inside
+            the row object of the `values` array.
+        */
+        column_estimate estimate;
+        estimate.name = name;
+        estimate.rows = values.size();
+        if (values.empty())
+        {
+            return estimate;
+        }
+
+        std::size_t sample_size = std::min(values.size(), payload_sample_size);
+        std::size_t sampled_bytes = 0;
+        std::unordered_set<std::size_t> distinct;
+
+        for (std::size_t i = 0; i < sample_size; ++i)
+        {
+            std::string dumped = nl::json(values[i * values.size() / sample_size]).dump();
+            sampled_bytes += dumped.size();
+            distinct.insert(std::hash<std::string>()(dumped));
+        }
+
+        estimate.mean_value_bytes = static_cast<double>(sampled_bytes) / sample_size;
+        estimate.distinct_ratio = static_cast<double>(distinct.size()) / sample_size;
+
+        std::size_t key_bytes = name.size() + 4;
+        estimate.bytes = static_cast<std::size_t>(
+            (estimate.mean_value_bytes + key_bytes) * values.size());
+        return estimate;
+    }
+
+    inline payload_estimate estimate_payload(const xv::df_type& df)
+    {
+        /*
+            Cheap pre-pass over the data frame, to be run before
+            `xv::mime_bundle_repr` builds the actual bundle.
+        */
+        payload_estimate estimate;
+        for (const auto& column : df)
+        {
+            column_estimate col = estimate_column(column.first, column.second);
+            estimate.rows = std::max(estimate.rows, col.rows);
+            estimate.total_bytes += col.bytes;
+            estimate.columns.push_back(std::move(col));
+        }
+        /** Braces and separator of each row object **/
+        estimate.total_bytes += 3 * estimate.rows;
+        return estimate;
+    }
+
+    inline void sample_rows(xv::df_type& df, std::size_t rows)
+    {
+        /*
+            Keeps `rows` evenly spaced rows, for every column.
+        */
+        for (auto& column : df)
+        {
+            auto& values = column.second;
+            std::size_t size = values.size();
+            if (rows >= size)
+            {
+                continue;
+            }
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                values[i] = std::move(values[i * size / rows]);
+            }
+            values.erase(values.begin() + rows, values.end());
+        }
+    }
+
+    inline void project_columns(xv::df_type& df,
+                                const std::vector<std::string>& used_fields)
+    {
+        /*
+            Drops every column that is not referenced by the chart encodings.
+        */
+        for (const auto& field : used_fields)
+        {
+            if (df.find(field) == df.end())
+            {
+                throw std::runtime_error("Missing or invalid field " + field);
+            }
+        }
+        for (auto it = df.begin(); it != df.end();)
+        {
+            if (std::find(used_fields.begin(), used_fields.end(), it->first) == used_fields.end())
+            {
+                it = df.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    inline void apply_payload_policy(xv::df_type& df,
+                                     const payload_policy& policy,
+                                     const std::vector<std::string>& used_fields)
+    {
+        /*
+            Enforces `policy` on the data frame. `used_fields` lists the columns
+            referenced by the chart encodings; PROJECT drops every other
+            column first and only samples rows if that is not enough.
+            Throws if the frame still does not fit once reduced.
+
+            Rows are never aggregated, the `distinct_ratio` of each column is
+            part of the estimate but no decision is based on it.
+        */
+        if (policy.max_bytes == 0)
+        {
+            return;
+        }
+
+        payload_estimate estimate = estimate_payload(df);
+        if (estimate.total_bytes <= policy.max_bytes)
+        {
+            return;
+        }
+
+        switch (policy.on_overflow)
+        {
+            case overflow_action::error:
+                break;
+            case overflow_action::project:
+                if (!used_fields.empty())
+                {
+                    project_columns(df, used_fields);
+                    estimate = estimate_payload(df);
+                    if (estimate.total_bytes <= policy.max_bytes)
+                    {
+                        return;
+                    }
+                }
+                [[fallthrough]];
+            case overflow_action::sample:
+                /** Shrinks until the re-estimate fits, usually in a single pass **/
+                while (estimate.rows > 0 && estimate.total_bytes > policy.max_bytes)
+                {
+                    double row_bytes = static_cast<double>(estimate.total_bytes) / estimate.rows;
+                    std::size_t rows = std::min(static_cast<std::size_t>(policy.max_bytes / row_bytes),
+                                                estimate.rows - 1);
+                    if (rows == 0)
+                    {
+                        break;
+                    }
+                    sample_rows(df, rows);
+                    estimate = estimate_payload(df);
+                }
+                if (estimate.total_bytes <= policy.max_bytes)
+                {
+                    return;
+                }
+                break;
+        }
+
+        throw std::runtime_error("Estimated chart size of " +
+                                 std::to_string(estimate.total_bytes) +
+                                 " bytes exceeds MAX_BYTES " +
+                                 std::to_string(policy.max_bytes) + ".");
+    }
+}
+
+#endif
@@ -17,7 +17,7 @@
 
 namespace xv_bindings
 {
-    static std::string sanitize_string(const std::string& code)
+    inline std::string sanitize_string(const std::string& code)
     {
         /*
             Cleans the code from inputs that are acceptable in a jupyter notebook.
@@ -34,7 +34,7 @@ namespace xv_bindings
         return aux;
     }
 
-    static bool case_insentive_equals(const std::string& a, const std::string& b)
+    inline bool case_insentive_equals(const std::string& a, const std::string& b)
     {
         return std::equal(a.begin(), a.end(), b.begin(),
                     [](unsigned char a, unsigned char b) {
@@ -42,7 +42,7 @@ namespace xv_bindings
                     });
     }
 
-    static bool is_xvega(std::vector<std::string>& tokenized_input)
+    inline bool is_xvega(std::vector<std::string>& tokenized_input)
     {
         /*
             Returns true if the code input is xvega and false if isn't.
@@ -50,7 +50,7 @@ namespace xv_bindings
         return tokenized_input[0] == "XVEGA_PLOT";
     }
 
-    static bool is_magic(std::vector<std::string> tokenized_input)
+    inline bool is_magic(std::vector<std::string> tokenized_input)
     {
         /*
             Returns true if the code input is magic and false if isn't.
@@ -58,7 +58,7 @@ namespace xv_bindings
         return tokenized_input[0][0] == '%';
     }
 
-    static std::vector<std::string> tokenizer(const std::string& input)
+    inline std::vector<std::string> tokenizer(const std::string& input)
     {
         /*
             Separetes the input with spaces.
@@ -75,7 +75,7 @@ namespace xv_bindings
         return tokenized_input;
     }
 
-    static std::string to_lower(const std::string& input)
+    inline std::string to_lower(const std::string& input)
     {
         std::string lower_case_input;
         lower_case_input.resize(input.length());
@@ -83,7 +83,7 @@ namespace xv_bindings
         return lower_case_input;
     }
 
-    static std::string to_upper(const std::string& input)
+    inline std::string to_upper(const std::string& input)
     {
         std::string upper_case_input;
         upper_case_input.resize(input.length());
@@ -11,23 +11,20 @@
 #define XVEGA_BINDINGS_HPP
 
 #include <algorithm>
-#include <any>
+#include <cctype>
 #include <functional>
-#include <iomanip>
-#include <iostream>
 #include <iterator>
 #include <map>
 #include <type_traits>
-#include <typeindex>
-#include <typeinfo>
-#include <unordered_map>
 #include <vector>
 #include <utility>
 
 #include "nlohmann/json.hpp"
 #include "xvega/xvega.hpp"
 
+#include "payload.hpp"
 #include "utils.hpp"
+#include "xvega_bindings_config.hpp"
 
 namespace nl = nlohmann;
 
@@ -201,45 +198,27 @@ namespace xv_bindings
 
             return it;
         }
+    };
 
-        /* Implementation of a visitor for xv::xany which is a xtl::any */
-        using visitor_map_type = std::unordered_map<std::type_index, std::function<void(xtl::any const&)>>;
-
-        template<typename U, typename F>
-        inline std::pair<const std::type_index, std::function<void(xtl::any const&)> >
-            to_any_visitor(F const &f)
-        {
-            return {
-                std::type_index(typeid(U)),
-                [=](xtl::any const &a)
-                {
-                    f(xtl::any_cast<U const&>(a));
-                }
-            };
-        }
+#ifdef XVEGA_BINDINGS_PRECOMPILED
+    struct bin_parser;
+    struct field_parser;
+    struct mark_parser;
+    struct xv_sqlite_parser;
 
-        inline void visit_any(const xtl::any& a, const visitor_map_type& any_visitor)
-        {
-            if (const auto it = any_visitor.find(std::type_index(a.type()));
-                it != any_visitor.cend()) {
-                it->second(a);
-            } else {
-                std::cout << "Unregistered type "<< std::quoted(a.type().name());
-            }
-        }
-
-        template<typename U, typename F>
-        inline void register_any_visitor(F const& f, visitor_map_type& any_visitor)
-        {
-            std::cout << "Register visitor for type "
-                      << std::quoted(typeid(U).name()) << '\n';
-            any_visitor.insert(to_any_visitor<U>(f));
-        }
-    };
+    /**
+        Instantiated once in the compiled xvega-bindings library. Declared
+        before the parsers derive from them so the export attribute applies.
+    **/
+    extern template struct XVEGA_BINDINGS_API parser_base<bin_parser>;
+    extern template struct XVEGA_BINDINGS_API parser_base<field_parser>;
+    extern template struct XVEGA_BINDINGS_API parser_base<mark_parser>;
+    extern template struct XVEGA_BINDINGS_API parser_base<xv_sqlite_parser>;
+#endif
 
     //TODO: I don't think most final value() calls are necessary
 
-    struct bin_parser : parser_base<bin_parser>
+    struct XVEGA_BINDINGS_API bin_parser : parser_base<bin_parser>
     {
         xv::Bin& bin;
         int num_parsed_attrs = 0;
@@ -314,7 +293,7 @@ namespace xv_bindings
         }
     };
 
-    struct field_parser : parser_base<field_parser>
+    struct XVEGA_BINDINGS_API field_parser : parser_base<field_parser>
     {
         using xy_variant = xtl::variant<xv::X*, xv::Y*>;
         xy_variant enc;
@@ -456,11 +435,28 @@ namespace xv_bindings
         }
     };
 
-    struct mark_parser : parser_base<mark_parser>
+    /** Closed set of marks a chart can be given with the MARK command **/
+    using mark_variant = xtl::variant<xv::mark_arc,
+                                      xv::mark_area,
+                                      xv::mark_bar,
+                                      xv::mark_circle,
+                                      xv::mark_line,
+                                      xv::mark_point,
+                                      xv::mark_rect,
+                                      xv::mark_rule,
+                                      xv::mark_square,
+                                      xv::mark_tick,
+                                      xv::mark_trail>;
+
+    /**
+        Mark properties are set in place on `mark`, the caller is responsible
+        for moving the parsed mark into the chart once parsing is done.
+    **/
+    struct XVEGA_BINDINGS_API mark_parser : parser_base<mark_parser>
     {
-        xv::Chart& chart;
+        mark_variant mark;
 
-        mark_parser(xv::Chart& chart) : chart(chart)
+        mark_parser()
         {
             mapping_table = {
                 {"COLOR", { 1, &mark_parser::parse_color }},
@@ -471,17 +467,17 @@ namespace xv_bindings
         {
             bool found = simple_switch(*begin,
             {
-                {"ARC",    [&]{ this->chart.mark() = xv::mark_arc();    }},
-                {"AREA",   [&]{ this->chart.mark() = xv::mark_area();   }},
-                {"BAR",    [&]{ this->chart.mark() = xv::mark_bar();    }},
-                {"CIRCLE", [&]{ this->chart.mark() = xv::mark_circle(); }},
-                {"LINE",   [&]{ this->chart.mark() = xv::mark_line();   }},
-                {"POINT",  [&]{ this->chart.mark() = xv::mark_point();  }},
-                {"RECT",   [&]{ this->chart.mark() = xv::mark_rect();   }},
-                {"RULE",   [&]{ this->chart.mark() = xv::mark_rule();   }},
-                {"SQUARE", [&]{ this->chart.mark() = xv::mark_square(); }},
-                {"TICK",   [&]{ this->chart.mark() = xv::mark_tick();   }},
-                {"TRAIL",  [&]{ this->chart.mark() = xv::mark_trail();  }},
+                {"ARC",    [&]{ this->mark = xv::mark_arc();    }},
+                {"AREA",   [&]{ this->mark = xv::mark_area();   }},
+                {"BAR",    [&]{ this->mark = xv::mark_bar();    }},
+                {"CIRCLE", [&]{ this->mark = xv::mark_circle(); }},
+                {"LINE",   [&]{ this->mark = xv::mark_line();   }},
+                {"POINT",  [&]{ this->mark = xv::mark_point();  }},
+                {"RECT",   [&]{ this->mark = xv::mark_rect();   }},
+                {"RULE",   [&]{ this->mark = xv::mark_rule();   }},
+                {"SQUARE", [&]{ this->mark = xv::mark_square(); }},
+                {"TICK",   [&]{ this->mark = xv::mark_tick();   }},
+                {"TRAIL",  [&]{ this->mark = xv::mark_trail();  }},
             });
             if (!found)
             {
@@ -492,38 +488,31 @@ namespace xv_bindings
 
         void parse_color(const input_it& it)
         {
-            visitor_map_type any_visitor {
-                to_any_visitor<xv::mark_arc>    ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-                to_any_visitor<xv::mark_area>   ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-                to_any_visitor<xv::mark_bar>    ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-                to_any_visitor<xv::mark_circle> ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-                to_any_visitor<xv::mark_line>   ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-                to_any_visitor<xv::mark_point>  ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-                to_any_visitor<xv::mark_rect>   ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-                to_any_visitor<xv::mark_rule>   ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-                to_any_visitor<xv::mark_square> ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-                to_any_visitor<xv::mark_tick>   ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-                to_any_visitor<xv::mark_trail>  ([&](auto mark_generic) { mark_generic.color = to_lower(*it); }),
-            };
-
-            visit_any(this->chart.mark(), any_visitor);
+            xtl::visit([&](auto &&mark_generic)
+            {
+                mark_generic.color = to_lower(*it);
+            }, this->mark);
         }
     };
 
-    struct xv_sqlite_parser : parser_base<xv_sqlite_parser>
+    struct XVEGA_BINDINGS_API xv_sqlite_parser : parser_base<xv_sqlite_parser>
     {
         xv::Chart& chart;
+        payload_policy policy;
+        std::vector<std::string> used_fields;
 
         xv_sqlite_parser(xv::Chart& chart) : chart(chart)
         {
             mapping_table = {
-                {"WIDTH",   { 1, &xv_sqlite_parser::parse_width   }},
-                {"HEIGHT",  { 1, &xv_sqlite_parser::parse_height  }},
-                {"X_FIELD", { 1, &xv_sqlite_parser::parse_x_field }},
-                {"Y_FIELD", { 1, &xv_sqlite_parser::parse_y_field }},
-                {"MARK",    { 1, &xv_sqlite_parser::parse_mark    }},
-                {"GRID",    { 1, &xv_sqlite_parser::parse_grid    }},
-                {"TITLE",   { 1, &xv_sqlite_parser::parse_title   }},
+                {"WIDTH",       { 1, &xv_sqlite_parser::parse_width       }},
+                {"HEIGHT",      { 1, &xv_sqlite_parser::parse_height      }},
+                {"X_FIELD",     { 1, &xv_sqlite_parser::parse_x_field     }},
+                {"Y_FIELD",     { 1, &xv_sqlite_parser::parse_y_field     }},
+                {"MARK",        { 1, &xv_sqlite_parser::parse_mark        }},
+                {"GRID",        { 1, &xv_sqlite_parser::parse_grid        }},
+                {"TITLE",       { 1, &xv_sqlite_parser::parse_title       }},
+                {"MAX_BYTES",   { 1, &xv_sqlite_parser::parse_max_bytes   }},
+                {"ON_OVERFLOW", { 1, &xv_sqlite_parser::parse_on_overflow }},
             };
         }
 
@@ -549,6 +538,7 @@ namespace xv_bindings
         {
             xv::X x_enc = xv::X();
             this->chart.encoding().value().x = x_enc;
+            this->used_fields.push_back(*begin);
 
             field_parser parser(&this->chart.encoding().value().x().value());
             return parser.parse_loop(begin, end);
@@ -558,6 +548,7 @@ namespace xv_bindings
         {
             xv::Y y_enc = xv::Y();
             this->chart.encoding().value().y = y_enc;
+            this->used_fields.push_back(*begin);
 
             field_parser parser(&this->chart.encoding().value().y().value());
             return parser.parse_loop(begin, end);
@@ -565,8 +556,15 @@ namespace xv_bindings
 
         input_it parse_mark(const input_it& input, const input_it& end)
         {
-            mark_parser parser(this->chart);
-            return parser.parse_loop(input, end);
+            mark_parser parser;
+            input_it it = parser.parse_loop(input, end);
+
+            xtl::visit([&](auto &&mark_generic)
+            {
+                this->chart.mark() = std::move(mark_generic);
+            }, parser.mark);
+
+            return it;
         }
 
         void parse_grid(const input_it& it)
@@ -582,6 +580,45 @@ namespace xv_bindings
             }
         }
 
+        void parse_max_bytes(const input_it& it)
+        {
+            const std::string& value = *it;
+            bool is_number = !value.empty() &&
+                             std::all_of(value.begin(), value.end(),
+                                         [](unsigned char c) { return std::isdigit(c); });
+            std::size_t max_bytes = 0;
+            if (is_number)
+            {
+                try
+                {
+                    max_bytes = std::stoull(value);
+                }
+                catch (const std::out_of_range&)
+                {
+                    max_bytes = 0;
+                }
+            }
+            if (max_bytes == 0)
+            {
+                throw std::runtime_error("Missing or invalid MAX_BYTES value");
+            }
+            this->policy.max_bytes = max_bytes;
+        }
+
+        void parse_on_overflow(const input_it& it)
+        {
+            bool found = simple_switch(*it,
+                {
+                    {"SAMPLE",    [&]{ this->policy.on_overflow = overflow_action::sample;    }},
+                    {"PROJECT",   [&]{ this->policy.on_overflow = overflow_action::project;   }},
+                    {"ERROR",     [&]{ this->policy.on_overflow = overflow_action::error;     }},
+                });
+            if (!found)
+            {
+                throw std::runtime_error("Missing or invalid ON_OVERFLOW type");
+            }
+        }
+
         //TODO: not working
         void parse_title(const input_it& it)
         {
@@ -590,30 +627,15 @@ namespace xv_bindings
         }
     };
 
-    static nl::json process_xvega_input(std::vector<std::string>
-                                               tokenized_input,
-                                               xv::df_type xv_sqlite_df)
-    {
-        /** Initializes and populates xeus_sqlite object **/
-        xv::Chart chart;
-        chart.encoding() = xv::Encodings();
-
-        /** Populates chart with data gathered on interpreter::process_SQLite_input **/
-        xv::data_frame data_frame;
-        data_frame.values = xv_sqlite_df;
-        chart.data() = data_frame;
-
-        /** Parse XVEGA_PLOT syntax **/
-        xv_sqlite_parser parser(chart);
-        auto last_parsed = parser.parse_loop(tokenized_input.begin(),
-                                             tokenized_input.end());
-        if (last_parsed != tokenized_input.end())
-        {
-            throw std::runtime_error("This is not a valid command for SQLite XVega.");
-        }
-
-        return xv::mime_bundle_repr(chart);
-    }
+#ifdef XVEGA_BINDINGS_PRECOMPILED
+    /** Defined in the compiled library, see xvega_bindings_impl.hpp **/
+    XVEGA_BINDINGS_API nl::json process_xvega_input(std::vector<std::string> tokenized_input,
+                                                    xv::df_type xv_sqlite_df);
+#endif
 }
 
+#ifndef XVEGA_BINDINGS_PRECOMPILED
+#include "xvega_bindings_impl.hpp"
+#endif
+
 #endif
@@ -0,0 +1,47 @@
+/***************************************************************************
+* Copyright (c) 2020, QuantStack and xeus-SQLite contributors              *
+*                                                                          *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XVEGA_BINDINGS_CONFIG_HPP
+#define XVEGA_BINDINGS_CONFIG_HPP
+
+/**
+    XVEGA_BINDINGS_PRECOMPILED is defined for consumers of the compiled
+    library target, XVEGA_BINDINGS_EXPORTS while building that library.
+    Without either the bindings stay header-only.
+**/
+#if defined(XVEGA_BINDINGS_PRECOMPILED) && !defined(XVEGA_BINDINGS_EXPORTS)
+    #define XVEGA_BINDINGS_USE_LIBRARY
+#endif
+
+#ifdef _WIN32
+    #if defined(XVEGA_BINDINGS_STATIC_LIB) || !defined(XVEGA_BINDINGS_PRECOMPILED)
+        #define XVEGA_BINDINGS_API
+    #elif defined(XVEGA_BINDINGS_EXPORTS)
+        #define XVEGA_BINDINGS_API __declspec(dllexport)
+    #else
+        #define XVEGA_BINDINGS_API __declspec(dllimport)
+    #endif
+#elif defined(XVEGA_BINDINGS_PRECOMPILED)
+    /** The library is built with hidden visibility, only API symbols are exported **/
+    #define XVEGA_BINDINGS_API __attribute__((visibility("default")))
+#else
+    #define XVEGA_BINDINGS_API
+#endif
+
+/**
+    Functions defined in xvega_bindings_impl.hpp are inline in header-only
+    mode, and compiled once into the library otherwise.
+**/
+#ifdef XVEGA_BINDINGS_PRECOMPILED
+    #define XVEGA_BINDINGS_INLINE
+#else
+    #define XVEGA_BINDINGS_INLINE inline
+#endif
+
+#endif
@@ -0,0 +1,55 @@
+/***************************************************************************
+* Copyright (c) 2020, QuantStack and xeus-SQLite contributors              *
+*                                                                          *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+/**
+    Definitions of the non-template functions of the bindings. Included
+    by xvega_bindings.hpp in header-only mode, where they are inline, and
+    exactly once by src/xvega_bindings.cpp when building the library.
+**/
+
+#ifndef XVEGA_BINDINGS_IMPL_HPP
+#define XVEGA_BINDINGS_IMPL_HPP
+
+#include "xvega_bindings.hpp"
+
+#ifdef XVEGA_BINDINGS_USE_LIBRARY
+#error "xvega_bindings_impl.hpp is compiled into the xvega-bindings library"
+#endif
+
+namespace xv_bindings
+{
+    XVEGA_BINDINGS_INLINE nl::json process_xvega_input(std::vector<std::string> tokenized_input,
+                                                       xv::df_type xv_sqlite_df)
+    {
+        /** Initializes and populates xeus_sqlite object **/
+        xv::Chart chart;
+        chart.encoding() = xv::Encodings();
+
+        /** Parse XVEGA_PLOT syntax **/
+        xv_sqlite_parser parser(chart);
+        auto last_parsed = parser.parse_loop(tokenized_input.begin(),
+                                             tokenized_input.end());
+        if (last_parsed != tokenized_input.end())
+        {
+            throw std::runtime_error("This is not a valid command for SQLite XVega.");
+        }
+
+        /** Enforces MAX_BYTES before the bundle is built **/
+        apply_payload_policy(xv_sqlite_df, parser.policy, parser.used_fields);
+
+        /** Populates chart with data gathered on interpreter::process_SQLite_input **/
+        xv::data_frame data_frame;
+        data_frame.values = xv_sqlite_df;
+        chart.data() = data_frame;
+
+        return xv::mime_bundle_repr(chart);
+    }
+}
+
+#endif
@@ -0,0 +1,26 @@
+/***************************************************************************
+* Copyright (c) 2020, QuantStack and xeus-SQLite contributors              *
+*                                                                          *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+/**
+    Translation unit of the compiled xvega-bindings library. Built with
+    XVEGA_BINDINGS_EXPORTS: `process_xvega_input` is compiled here from
+    xvega_bindings_impl.hpp, and the parsers are explicitly instantiated
+    once for every consumer. Their export attribute comes from the
+    extern template declarations in xvega_bindings.hpp.
+**/
+#include "xvega-bindings/xvega_bindings.hpp"
+#include "xvega-bindings/xvega_bindings_impl.hpp"
+
+namespace xv_bindings
+{
+    template struct parser_base<bin_parser>;
+    template struct parser_base<field_parser>;
+    template struct parser_base<mark_parser>;
+    template struct parser_base<xv_sqlite_parser>;
+}
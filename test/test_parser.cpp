@@ -0,0 +1,71 @@
+/***************************************************************************
+* Copyright (c) 2020, QuantStack and xeus-SQLite contributors              *
+*                                                                          *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "xvega-bindings/xvega_bindings.hpp"
+
+#include "test_utils.hpp"
+
+namespace xb = xv_bindings;
+
+template <class M>
+static void check_mark(const std::string& input, const std::string& color)
+{
+    xv::Chart chart;
+    xb::xv_sqlite_parser parser(chart);
+    std::vector<std::string> tokens = xb::tokenizer(input);
+    CHECK(parser.parse_loop(tokens.begin(), tokens.end()) == tokens.end());
+
+    /** The mark type is preserved and COLOR is set on the chart's mark **/
+    CHECK(chart.mark().type() == typeid(M));
+    if (chart.mark().type() == typeid(M))
+    {
+        M& mark = xtl::any_cast<M&>(chart.mark());
+        CHECK(mark.color().has_value() && mark.color().value() == color);
+    }
+}
+
+static void test_mark_color()
+{
+    check_mark<xv::mark_bar>("MARK BAR COLOR RED", "red");
+    check_mark<xv::mark_line>("WIDTH 100 MARK line color Blue HEIGHT 50", "blue");
+    check_mark<xv::mark_trail>("MARK TRAIL COLOR green", "green");
+}
+
+static void test_invalid_mark()
+{
+    xv::Chart chart;
+    xb::xv_sqlite_parser parser(chart);
+    std::vector<std::string> tokens = xb::tokenizer("MARK PIE");
+    CHECK(throws([&]{ parser.parse_loop(tokens.begin(), tokens.end()); }));
+}
+
+static void test_process_xvega_input()
+{
+    xv::df_type df;
+    df["a"].push_back(1.5);
+    df["b"].push_back(2.5);
+
+    std::vector<std::string> tokens = xb::tokenizer("X_FIELD a Y_FIELD b MARK BAR MAX_BYTES 1000");
+    CHECK(!throws([&]{ xb::process_xvega_input(tokens, df); }));
+
+    std::vector<std::string> bad_tokens = xb::tokenizer("X_FIELD a NOT_A_COMMAND");
+    CHECK(throws([&]{ xb::process_xvega_input(bad_tokens, df); }));
+}
+
+int main()
+{
+    test_mark_color();
+    test_invalid_mark();
+    test_process_xvega_input();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,150 @@
+/***************************************************************************
+* Copyright (c) 2020, QuantStack and xeus-SQLite contributors              *
+*                                                                          *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <string>
+#include <vector>
+
+#include "xvega-bindings/xvega_bindings.hpp"
+
+#include "test_utils.hpp"
+
+namespace xb = xv_bindings;
+
+static xv::df_type make_df(std::size_t rows)
+{
+    xv::df_type df;
+    for (std::size_t i = 0; i < rows; ++i)
+    {
+        df["a"].push_back(1.5);
+        df["b"].push_back(2.5);
+        df["c"].push_back(3.5);
+    }
+    return df;
+}
+
+static void test_estimate()
+{
+    /** `"a":1.5,` per cell and `{},` per row **/
+    xb::payload_estimate estimate = xb::estimate_payload(make_df(100));
+    CHECK(estimate.rows == 100);
+    CHECK(estimate.columns.size() == 3);
+    CHECK(estimate.columns[0].bytes == 100 * 8);
+    CHECK(estimate.total_bytes == 3 * 100 * 8 + 3 * 100);
+    CHECK(estimate.columns[0].distinct_ratio == 1.0 / 64);
+
+    CHECK(xb::estimate_payload(xv::df_type()).total_bytes == 0);
+}
+
+static void test_estimate_strings()
+{
+    /** Strings of 1 to 8 characters, dumped with their quotes **/
+    xv::df_type df;
+    for (std::size_t i = 0; i < 64; ++i)
+    {
+        df["s"].push_back(std::string(i % 8 + 1, 'x'));
+    }
+    xb::payload_estimate estimate = xb::estimate_payload(df);
+    CHECK(estimate.columns.size() == 1);
+    CHECK(estimate.columns[0].mean_value_bytes == 6.5);
+    CHECK(estimate.columns[0].distinct_ratio == 8.0 / 64);
+    CHECK(estimate.columns[0].bytes == static_cast<std::size_t>((6.5 + 5) * 64));
+    CHECK(estimate.total_bytes == estimate.columns[0].bytes + 3 * 64);
+}
+
+static void test_sample_fits()
+{
+    /** 27 bytes per row, the sampled frame must fit right under the limit **/
+    const std::size_t cases[][3] = {
+        {1000, 1001, 37},
+        {1000, 300, 11},
+        {10, 100, 3},
+        {50, 100, 3},
+    };
+    for (const auto& c : cases)
+    {
+        xv::df_type df = make_df(c[0]);
+        xb::payload_policy policy;
+        policy.max_bytes = c[1];
+        policy.on_overflow = xb::overflow_action::sample;
+        CHECK(!throws([&]{ xb::apply_payload_policy(df, policy, {}); }));
+        CHECK(df["a"].size() == c[2]);
+        CHECK(xb::estimate_payload(df).total_bytes <= policy.max_bytes);
+    }
+
+    xv::df_type df = make_df(1000);
+    xb::payload_policy policy;
+    policy.max_bytes = 26;
+    policy.on_overflow = xb::overflow_action::sample;
+    CHECK(throws([&]{ xb::apply_payload_policy(df, policy, {}); }));
+}
+
+static void test_policy()
+{
+    xv::df_type df = make_df(100);
+    xb::payload_policy policy;
+    xb::apply_payload_policy(df, policy, {"a"});
+    CHECK(df.size() == 3 && df["a"].size() == 100);
+
+    policy.max_bytes = 1000;
+    policy.on_overflow = xb::overflow_action::error;
+    CHECK(throws([&]{ xb::apply_payload_policy(df, policy, {"a"}); }));
+
+    policy.on_overflow = xb::overflow_action::sample;
+    xb::apply_payload_policy(df, policy, {"a"});
+    CHECK(df.size() == 3);
+    CHECK(xb::estimate_payload(df).total_bytes <= policy.max_bytes);
+
+    df = make_df(100);
+    policy.max_bytes = 1200;
+    policy.on_overflow = xb::overflow_action::project;
+    xb::apply_payload_policy(df, policy, {"a"});
+    CHECK(df.size() == 1 && df.count("a") == 1 && df["a"].size() == 100);
+
+    df = make_df(100);
+    policy.max_bytes = 500;
+    xb::apply_payload_policy(df, policy, {"a"});
+    CHECK(df.size() == 1 && df["a"].size() < 100);
+
+    df = make_df(100);
+    CHECK(throws([&]{ xb::apply_payload_policy(df, policy, {"typo"}); }));
+    CHECK(df.size() == 3);
+
+    df = make_df(100);
+    policy.max_bytes = 1;
+    policy.on_overflow = xb::overflow_action::sample;
+    CHECK(throws([&]{ xb::apply_payload_policy(df, policy, {"a"}); }));
+}
+
+static void test_parser()
+{
+    xv::Chart chart;
+    xb::xv_sqlite_parser parser(chart);
+    std::vector<std::string> tokens = xb::tokenizer("MAX_BYTES 2048 ON_OVERFLOW project");
+    CHECK(parser.parse_loop(tokens.begin(), tokens.end()) == tokens.end());
+    CHECK(parser.policy.max_bytes == 2048);
+    CHECK(parser.policy.on_overflow == xb::overflow_action::project);
+
+    for (const char* input : {"MAX_BYTES -1", "MAX_BYTES 0", "MAX_BYTES abc",
+                               "MAX_BYTES 99999999999999999999999", "ON_OVERFLOW AGGREGATE"})
+    {
+        xb::xv_sqlite_parser bad(chart);
+        std::vector<std::string> bad_tokens = xb::tokenizer(input);
+        CHECK(throws([&]{ bad.parse_loop(bad_tokens.begin(), bad_tokens.end()); }));
+    }
+}
+
+int main()
+{
+    test_estimate();
+    test_estimate_strings();
+    test_policy();
+    test_sample_fits();
+    test_parser();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,43 @@
+/***************************************************************************
+* Copyright (c) 2020, QuantStack and xeus-SQLite contributors              *
+*                                                                          *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XVEGA_BINDINGS_TEST_UTILS_HPP
+#define XVEGA_BINDINGS_TEST_UTILS_HPP
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+inline int failures = 0;
+
+#define CHECK(cond)                                                        \
+    do                                                                     \
+    {                                                                      \
+        if (!(cond))                                                       \
+        {                                                                  \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " #cond "\n";   \
+            ++failures;                                                    \
+        }                                                                  \
+    } while (0)
+
+template <class F>
+bool throws(F&& f)
+{
+    try
+    {
+        f();
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+#endif